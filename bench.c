@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "lib_tar.h"
+
+/**
+ * Benchmark harness: times one function of lib_tar on one archive with 1..N threads, each thread using its own file
+ * descriptor, and prints one JSON object per thread count on stdout.
+ *
+ * Syscalls, headers and blocks per operation come from the tar_stats_* counters, which slow every call down (timer
+ * reads, atomic updates of counters shared by all threads). The Makefile therefore builds this file twice:
+ *  - `bench` against the library without TAR_STATS: its latencies are those of the shipped library, counters are null,
+ *  - `bench_stats` against the library with TAR_STATS: its counters are exact, its latencies include the overhead.
+ * The "build" field of each result says which one produced it.
+ */
+
+typedef struct bench_config
+{
+    const char *archive;
+    tar_op_t op;
+    char *path;
+    size_t iterations;  /* operations per thread */
+    size_t offset;      /* offset given to read_file() */
+    size_t buf_size;    /* size of the read_file() buffer */
+    size_t no_entries;  /* size of the list() array */
+    int cold;           /* drop the archive from the page cache before each operation */
+} bench_config_t;
+
+typedef struct bench_thread
+{
+    pthread_t thread;
+    const bench_config_t *config;
+    uint64_t *latencies;
+    size_t done;        /* operations completed, the thread stops at the first failure */
+    uint64_t start_ns;
+    uint64_t end_ns;
+    tar_stats_t stats;
+    int failed;
+} bench_thread_t;
+
+#ifdef TAR_STATS
+#define BENCH_BUILD "stats"
+#else
+#define BENCH_BUILD "plain"
+#endif
+
+static pthread_barrier_t start_barrier;
+
+uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-t THREADS] [-n ITERATIONS] [-b BUF_SIZE] [-o OFFSET] [-e NO_ENTRIES] [-c] ARCHIVE OP [PATH]\n"
+            "  OP is one of check_archive, exists, list, read_file (PATH is required but for check_archive)\n"
+            "  -t  run with 1, 2, 4, ... up to THREADS threads (default 1)\n"
+            "  -n  operations per thread (default 100)\n"
+            "  -b  read_file() buffer size (default 4096)\n"
+            "  -o  read_file() offset (default 0)\n"
+            "  -e  list() entries (default 1024)\n"
+            "  -c  cold cache: drop the archive from the page cache before each operation\n",
+            prog);
+}
+
+/**
+ * Run one operation of the benchmark.
+ *
+ * @return zero if the function reported what the benchmark expects (archive valid, entry found, ...),
+ *         -1 otherwise.
+ */
+int run_op(int tar_fd, const bench_config_t *config, uint8_t *buf, char **entries) {
+    switch (config->op) {
+        case TAR_OP_CHECK_ARCHIVE:
+            return check_archive(tar_fd) >= 0 ? 0 : -1;
+        case TAR_OP_EXISTS:
+            return exists(tar_fd, config->path) ? 0 : -1;
+        case TAR_OP_LIST: {
+            size_t no_entries = config->no_entries;
+            return list(tar_fd, config->path, entries, &no_entries) ? 0 : -1;
+        }
+        case TAR_OP_READ_FILE: {
+            size_t len = config->buf_size;
+            return read_file(tar_fd, config->path, config->offset, buf, &len) >= 0 ? 0 : -1;
+        }
+        default:
+            return -1;
+    }
+}
+
+void *bench_thread(void *arg) {
+    bench_thread_t *self = arg;
+    const bench_config_t *config = self->config;
+
+    int tar_fd = open(config->archive, O_RDONLY);
+    uint8_t *buf = malloc(config->buf_size);
+    char **entries = malloc(sizeof(char *) * config->no_entries);
+    for (size_t i = 0; i < config->no_entries; i++) entries[i] = malloc(sizeof(char) * 100);
+
+    if (tar_fd == -1) { perror("open(archive)"); self->failed = 1; }
+    else if (!config->cold) run_op(tar_fd, config, buf, entries); // Warm the page cache up
+
+    tar_stats_reset_fd(tar_fd); // Forget the warm-up and the previous runs that used the same fd
+    pthread_barrier_wait(&start_barrier);
+
+    self->start_ns = now_ns();
+    for (size_t i = 0; i < config->iterations && !self->failed; i++) {
+        if (config->cold) {
+            int err = posix_fadvise(tar_fd, 0, 0, POSIX_FADV_DONTNEED);
+            if (err != 0) {
+                fprintf(stderr, "bench: posix_fadvise(DONTNEED): %s\n", strerror(err));
+                self->failed = 1;
+                break;
+            }
+        }
+        uint64_t start = now_ns();
+        if (run_op(tar_fd, config, buf, entries) != 0) { self->failed = 1; break; }
+        self->latencies[self->done++] = now_ns() - start;
+    }
+    self->end_ns = now_ns();
+
+    tar_stats_get_fd(tar_fd, &self->stats);
+
+    for (size_t i = 0; i < config->no_entries; i++) free(entries[i]);
+    free(entries);
+    free(buf);
+    if (tar_fd != -1) close(tar_fd);
+    return NULL;
+}
+
+/**
+ * Run the benchmark with a given number of threads and print its results.
+ *
+ * @return zero on success, -1 if an operation failed.
+ */
+int bench(const bench_config_t *config, int nbr_threads) {
+    bench_thread_t *threads = calloc(nbr_threads, sizeof(bench_thread_t));
+    uint64_t *latencies = malloc(sizeof(uint64_t) * config->iterations * nbr_threads);
+    pthread_barrier_init(&start_barrier, NULL, nbr_threads + 1);
+
+    for (int i = 0; i < nbr_threads; i++) {
+        threads[i].config = config;
+        threads[i].latencies = latencies + config->iterations * i;
+        pthread_create(&threads[i].thread, NULL, bench_thread, &threads[i]);
+    }
+    pthread_barrier_wait(&start_barrier);
+
+    int failed = 0;
+    uint64_t start = UINT64_MAX, end = 0;
+    size_t nbr_ops = 0;
+    uint64_t syscalls = 0, headers = 0, blocks = 0;
+    for (int i = 0; i < nbr_threads; i++) {
+        pthread_join(threads[i].thread, NULL);
+        failed |= threads[i].failed;
+        memmove(latencies + nbr_ops, threads[i].latencies, sizeof(uint64_t) * threads[i].done);
+        nbr_ops += threads[i].done;
+        syscalls += threads[i].stats.reads + threads[i].stats.seeks;
+        headers += threads[i].stats.headers_scanned;
+        blocks += threads[i].stats.blocks_scanned;
+        if (threads[i].start_ns < start) start = threads[i].start_ns;
+        if (threads[i].end_ns > end) end = threads[i].end_ns;
+    }
+    uint64_t elapsed = end > start ? end - start : 1;
+    pthread_barrier_destroy(&start_barrier);
+
+    size_t nbr_samples = nbr_ops > 0 ? nbr_ops : 1; // Report zeros if the first operation already failed
+    if (nbr_ops == 0) latencies[0] = 0;
+    qsort(latencies, nbr_ops, sizeof(uint64_t), cmp_u64);
+
+    printf("{\"archive\":\"%s\",\"op\":\"%s\",\"path\":\"%s\",\"offset\":%zu,\"build\":\"%s\",\"cache\":\"%s\","
+           "\"threads\":%d,\"ops\":%zu,\"seconds\":%.6f,\"ops_per_sec\":%.1f,"
+           "\"p50_ns\":%" PRIu64 ",\"p99_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64 ",",
+           config->archive, tar_op_name(config->op), config->path != NULL ? config->path : "", config->offset,
+           BENCH_BUILD, config->cold ? "cold" : "warm", nbr_threads, nbr_ops,
+           elapsed / 1e9, nbr_ops / (elapsed / 1e9),
+           latencies[nbr_ops / 2], latencies[nbr_ops * 99 / 100], latencies[nbr_samples - 1]);
+#ifdef TAR_STATS
+    printf("\"syscalls_per_op\":%.2f,\"headers_per_op\":%.2f,\"blocks_per_op\":%.2f,",
+           (double) syscalls / nbr_samples, (double) headers / nbr_samples, (double) blocks / nbr_samples);
+#else
+    (void) syscalls; (void) headers; (void) blocks;
+    printf("\"syscalls_per_op\":null,\"headers_per_op\":null,\"blocks_per_op\":null,");
+#endif
+    printf("\"failed\":%s}\n", failed ? "true" : "false");
+    fflush(stdout);
+
+    free(latencies);
+    free(threads);
+    return failed ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+    bench_config_t config = {.iterations = 100, .buf_size = 4096, .no_entries = 1024};
+    int max_threads = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:n:b:o:e:c")) != -1) {
+        switch (opt) {
+            case 't': max_threads = atoi(optarg); break;
+            case 'n': config.iterations = strtoul(optarg, NULL, 10); break;
+            case 'b': config.buf_size = strtoul(optarg, NULL, 10); break;
+            case 'o': config.offset = strtoul(optarg, NULL, 10); break;
+            case 'e': config.no_entries = strtoul(optarg, NULL, 10); break;
+            case 'c': config.cold = 1; break;
+            default: usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind < 2 || max_threads < 1 || config.iterations < 1 || config.buf_size < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    config.archive = argv[optind];
+    const char *op_name = argv[optind + 1];
+    config.path = argc - optind > 2 ? argv[optind + 2] : NULL;
+
+    config.op = TAR_OP_COUNT;
+    const tar_op_t ops[] = {TAR_OP_CHECK_ARCHIVE, TAR_OP_EXISTS, TAR_OP_LIST, TAR_OP_READ_FILE};
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        if (strcmp(op_name, tar_op_name(ops[i])) == 0) config.op = ops[i];
+    }
+    if (config.op == TAR_OP_COUNT || (config.op != TAR_OP_CHECK_ARCHIVE && config.path == NULL)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // POSIX_FADV_DONTNEED does not evict dirty pages, and the archive may just have been written by bench_gen
+    if (config.cold) {
+        int tar_fd = open(config.archive, O_RDONLY);
+        if (tar_fd == -1 || fdatasync(tar_fd) != 0) {
+            perror("bench: fdatasync(archive)");
+            if (tar_fd != -1) close(tar_fd);
+            return EXIT_FAILURE;
+        }
+        close(tar_fd);
+    }
+
+    int status = EXIT_SUCCESS;
+    for (int nbr_threads = 1; ; nbr_threads *= 2) {
+        if (nbr_threads > max_threads) nbr_threads = max_threads;
+        if (bench(&config, nbr_threads) != 0) status = EXIT_FAILURE;
+        if (nbr_threads == max_threads) break;
+    }
+    return status;
+}
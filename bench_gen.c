@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/types.h>
+
+#include "lib_tar.h"
+
+/**
+ * Generator of synthetic ustar archives for the benchmarks (see bench.c and `make bench-run`).
+ *
+ * Every archive is written in the order tar itself would write it: a directory header is directly followed by its
+ * content, which is what list() relies on.
+ */
+
+#define BLOCK_SIZE sizeof(tar_header_t)
+#define NAME_MAX_LEN 99 /* the name field must stay null-terminated */
+#define SIZE_MAX_VAL UINT64_C(077777777777) /* the size field holds 11 octal digits */
+
+static FILE *out;
+
+void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s KIND OUT.tar [ARGS...]\n"
+            "  tiny  OUT.tar N                      N tiny files, 1000 per directory        (files: t/0/0 ...)\n"
+            "  tree  OUT.tar DEPTH FANOUT FILES     a tree of directories, FILES files each (dirs: r/0/1/ ...)\n"
+            "  big   OUT.tar MB                     one member of MB mebibytes, then a small one (files: big, after)\n"
+            "  chain OUT.tar N                      chains of N symlinks to a file and a dir (links: chain/f0, chain/d0)\n"
+            "  dir   OUT.tar N                      one directory holding N empty files     (dir: wide/)\n"
+            "The data of `big` is a hole (sparse file) so that multi-GB archives cost no disk space: its blocks are\n"
+            "still read one by one by the lookup of `after`, but come from zeroed pages, even in cold runs.\n",
+            prog);
+}
+
+/**
+ * Write one header, its data and the padding of the last block.
+ *
+ * @param name The path of the entry, directories end with a '/'.
+ * @param typeflag REGTYPE, DIRTYPE or SYMTYPE.
+ * @param size The size of the data.
+ * @param linkname The target of a symlink, NULL otherwise.
+ * @param data The data to write, NULL to leave a hole of `size` bytes.
+ */
+void write_entry(const char *name, char typeflag, uint64_t size, const char *linkname, const uint8_t *data) {
+    if (strlen(name) > NAME_MAX_LEN) {
+        fprintf(stderr, "bench_gen: name too long: %s\n", name);
+        exit(EXIT_FAILURE);
+    }
+    if (size > SIZE_MAX_VAL) {
+        fprintf(stderr, "bench_gen: size too large for the ustar size field: %s (%" PRIu64 " bytes)\n", name, size);
+        exit(EXIT_FAILURE);
+    }
+
+    tar_header_t header;
+    memset(&header, 0, sizeof(tar_header_t));
+    strncpy(header.name, name, sizeof(header.name));
+    snprintf(header.mode, sizeof(header.mode), "%07o", typeflag == DIRTYPE ? 0755 : 0644);
+    snprintf(header.uid, sizeof(header.uid), "%07o", 0);
+    snprintf(header.gid, sizeof(header.gid), "%07o", 0);
+    snprintf(header.size, sizeof(header.size), "%011" PRIo64, size);
+    snprintf(header.mtime, sizeof(header.mtime), "%011o", 0);
+    header.typeflag = typeflag;
+    if (linkname != NULL) strncpy(header.linkname, linkname, sizeof(header.linkname) - 1);
+    memcpy(header.magic, TMAGIC, TMAGLEN);
+    memcpy(header.version, TVERSION, TVERSLEN);
+
+    u_int chksum = 0;
+    memset(header.chksum, ' ', sizeof(header.chksum));
+    for (size_t i = 0; i < BLOCK_SIZE; i++) chksum += ((char *) &header)[i];
+    snprintf(header.chksum, sizeof(header.chksum), "%06o", chksum);
+
+    fwrite(&header, BLOCK_SIZE, 1, out);
+    if (size == 0) return;
+
+    uint64_t padded = (size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    if (data != NULL) {
+        static const uint8_t zeros[BLOCK_SIZE];
+        fwrite(data, size, 1, out);
+        fwrite(zeros, padded - size, 1, out);
+    } else {
+        fseeko(out, (off_t) padded, SEEK_CUR);
+    }
+}
+
+void gen_tiny(size_t n) {
+    uint8_t data[64];
+    char name[NAME_MAX_LEN + 1];
+    write_entry("t/", DIRTYPE, 0, NULL, NULL);
+    for (size_t i = 0; i < n; i++) {
+        if (i % 1000 == 0) {
+            snprintf(name, sizeof(name), "t/%lx/", (u_long) (i / 1000));
+            write_entry(name, DIRTYPE, 0, NULL, NULL);
+        }
+        size_t size = 1 + i % sizeof(data);
+        memset(data, 'a' + (int) (i % 26), size);
+        snprintf(name, sizeof(name), "t/%lx/%lx", (u_long) (i / 1000), (u_long) (i % 1000));
+        write_entry(name, REGTYPE, size, NULL, data);
+    }
+}
+
+/**
+ * Append a component to a path, exit if the result does not fit in the name field.
+ *
+ * @param path The path, at least NAME_MAX_LEN + 1 bytes long.
+ * @param len The length of the path.
+ * @param fmt The format of the component, taking one int.
+ * @param i The argument of the format.
+ */
+void path_append(char *path, size_t len, const char *fmt, int i) {
+    int n = snprintf(path + len, NAME_MAX_LEN + 1 - len, fmt, i);
+    if (n < 0 || len + n > NAME_MAX_LEN) {
+        path[len] = '\0';
+        fprintf(stderr, "bench_gen: name too long: %s + \"", path);
+        fprintf(stderr, fmt, i);
+        fprintf(stderr, "\" (at most %d characters)\n", NAME_MAX_LEN);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Write the directory `path` and, recursively, `fanout` sub-directories until `depth` levels are written.
+ */
+void gen_tree(char *path, int depth, int fanout, int files) {
+    size_t len = strlen(path);
+    write_entry(path, DIRTYPE, 0, NULL, NULL);
+
+    for (int i = 0; i < files; i++) {
+        path_append(path, len, "f%x", i);
+        write_entry(path, REGTYPE, len, NULL, (const uint8_t *) path);
+    }
+    if (depth > 0) {
+        for (int i = 0; i < fanout; i++) {
+            path_append(path, len, "%x/", i);
+            gen_tree(path, depth - 1, fanout, files);
+        }
+    }
+    path[len] = '\0';
+}
+
+void gen_big(size_t mb) {
+    if (mb > SIZE_MAX_VAL >> 20) {
+        fprintf(stderr, "bench_gen: member too large: %zu MiB (at most %" PRIu64 ")\n", mb, SIZE_MAX_VAL >> 20);
+        exit(EXIT_FAILURE);
+    }
+    write_entry("big", REGTYPE, (uint64_t) mb << 20, NULL, NULL);
+    write_entry("after", REGTYPE, 5, NULL, (const uint8_t *) "after");
+}
+
+void gen_chain(size_t n) {
+    char name[NAME_MAX_LEN + 1], link[NAME_MAX_LEN + 1];
+    write_entry("chain/", DIRTYPE, 0, NULL, NULL);
+    write_entry("chain/dir/", DIRTYPE, 0, NULL, NULL);
+    write_entry("chain/dir/file", REGTYPE, 5, NULL, (const uint8_t *) "chain");
+    write_entry("chain/file", REGTYPE, 5, NULL, (const uint8_t *) "chain");
+
+    for (int kind = 0; kind < 2; kind++) {
+        char prefix = kind == 0 ? 'f' : 'd';
+        for (size_t i = 0; i < n; i++) {
+            snprintf(name, sizeof(name), "chain/%c%lu", prefix, (u_long) i);
+            if (i + 1 < n) snprintf(link, sizeof(link), "%c%lu", prefix, (u_long) (i + 1));
+            else snprintf(link, sizeof(link), "%s", kind == 0 ? "file" : "dir");
+            write_entry(name, SYMTYPE, 0, link, NULL);
+        }
+    }
+}
+
+void gen_dir(size_t n) {
+    char name[NAME_MAX_LEN + 1];
+    write_entry("wide/", DIRTYPE, 0, NULL, NULL);
+    for (size_t i = 0; i < n; i++) {
+        snprintf(name, sizeof(name), "wide/%lx", (u_long) i);
+        write_entry(name, REGTYPE, 0, NULL, NULL);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) { usage(argv[0]); return EXIT_FAILURE; }
+    const char *kind = argv[1];
+
+    out = fopen(argv[2], "w");
+    if (out == NULL) {
+        perror("fopen(out)");
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(kind, "tiny") == 0) gen_tiny(strtoul(argv[3], NULL, 10));
+    else if (strcmp(kind, "big") == 0) gen_big(strtoul(argv[3], NULL, 10));
+    else if (strcmp(kind, "chain") == 0) gen_chain(strtoul(argv[3], NULL, 10));
+    else if (strcmp(kind, "dir") == 0) gen_dir(strtoul(argv[3], NULL, 10));
+    else if (strcmp(kind, "tree") == 0 && argc >= 6) {
+        char path[NAME_MAX_LEN + 1] = "r/";
+        gen_tree(path, atoi(argv[3]), atoi(argv[4]), atoi(argv[5]));
+    } else {
+        usage(argv[0]);
+        fclose(out);
+        return EXIT_FAILURE;
+    }
+
+    /* End of archive: two null blocks */
+    static const uint8_t zeros[2 * BLOCK_SIZE];
+    fwrite(zeros, sizeof(zeros), 1, out);
+
+    if (fclose(out) != 0) {
+        perror("fclose(out)");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,5 +1,7 @@
 #include "lib_tar.h"
 #include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
 
 void debug(const uint8_t *bytes, size_t len) {
     for (int i = 0; i < len;) {
@@ -16,6 +18,216 @@ void debug(const uint8_t *bytes, size_t len) {
     }
 }
 
+#ifdef TAR_STATS
+static tar_stats_t global_stats;
+static tar_stats_t fd_stats[TAR_STATS_MAX_FD];
+
+/* Relaxed atomics: the counters may be updated from several threads, each one using its own file descriptor */
+#define STATS_ADD(fd, field, n) do { \
+        __atomic_fetch_add(&global_stats.field, (uint64_t) (n), __ATOMIC_RELAXED); \
+        if ((fd) >= 0 && (fd) < TAR_STATS_MAX_FD) __atomic_fetch_add(&fd_stats[fd].field, (uint64_t) (n), __ATOMIC_RELAXED); \
+    } while (0)
+#define STATS_MAX(fd, field, n) do { \
+        stats_max(&global_stats.field, (uint64_t) (n)); \
+        if ((fd) >= 0 && (fd) < TAR_STATS_MAX_FD) stats_max(&fd_stats[fd].field, (uint64_t) (n)); \
+    } while (0)
+
+static void stats_max(uint64_t *counter, uint64_t value) {
+    uint64_t curr = __atomic_load_n(counter, __ATOMIC_RELAXED);
+    while (curr < value && !__atomic_compare_exchange_n(counter, &curr, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/* tar_stats_t only holds uint64_t counters, so it is copied and cleared one atomic word at a time */
+#define STATS_WORDS (sizeof(tar_stats_t) / sizeof(uint64_t))
+
+static void stats_copy(tar_stats_t *dest, tar_stats_t *src) {
+    for (size_t i = 0; i < STATS_WORDS; i++) {
+        ((uint64_t *) dest)[i] = __atomic_load_n(&((uint64_t *) src)[i], __ATOMIC_RELAXED);
+    }
+}
+
+static void stats_clear(tar_stats_t *stats) {
+    for (size_t i = 0; i < STATS_WORDS; i++) __atomic_store_n(&((uint64_t *) stats)[i], 0, __ATOMIC_RELAXED);
+}
+#else
+#define STATS_ADD(fd, field, n) ((void) (fd), (void) (n))
+#define STATS_MAX(fd, field, n) ((void) (fd), (void) (n))
+#endif
+
+/**
+ * Get the timestamp of the beginning of an API call.
+ *
+ * @return a monotonic time in nanoseconds, or 0 if the library is compiled without TAR_STATS.
+ */
+static inline uint64_t stats_begin(void) {
+#ifdef TAR_STATS
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Record the latency of an API call started at stats_begin().
+ *
+ * @param tar_fd The file descriptor the call was made with.
+ * @param op The function called.
+ * @param start The value returned by stats_begin().
+ */
+static inline void stats_end(int tar_fd, tar_op_t op, uint64_t start) {
+#ifdef TAR_STATS
+    uint64_t elapsed = stats_begin() - start;
+    int bucket = elapsed == 0 ? 0 : 63 - __builtin_clzll(elapsed);
+    if (bucket >= TAR_STATS_BUCKETS) bucket = TAR_STATS_BUCKETS - 1;
+
+    STATS_ADD(tar_fd, ops[op].calls, 1);
+    STATS_ADD(tar_fd, ops[op].total_ns, elapsed);
+    STATS_ADD(tar_fd, ops[op].latency[bucket], 1);
+    STATS_MAX(tar_fd, ops[op].max_ns, elapsed);
+#else
+    (void) tar_fd; (void) op; (void) start;
+#endif
+}
+
+/**
+ * Copies the counters of all the calls made so far.
+ *
+ * @param stats The destination of the counters.
+ */
+void tar_stats_get(tar_stats_t *stats) {
+#ifdef TAR_STATS
+    stats_copy(stats, &global_stats);
+#else
+    memset(stats, 0, sizeof(tar_stats_t));
+#endif
+}
+
+/**
+ * Copies the counters of the calls made so far with a given file descriptor.
+ *
+ * @param tar_fd A file descriptor previously given to the functions above.
+ * @param stats The destination of the counters.
+ *
+ * @return zero on success,
+ *         -1 if tar_fd has no counters of its own (TAR_STATS disabled or tar_fd >= TAR_STATS_MAX_FD)
+ */
+int tar_stats_get_fd(int tar_fd, tar_stats_t *stats) {
+    memset(stats, 0, sizeof(tar_stats_t));
+#ifdef TAR_STATS
+    if (tar_fd < 0 || tar_fd >= TAR_STATS_MAX_FD) return -1;
+    stats_copy(stats, &fd_stats[tar_fd]);
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Resets the global counters and the counters of every file descriptor.
+ */
+void tar_stats_reset(void) {
+#ifdef TAR_STATS
+    stats_clear(&global_stats);
+    for (int i = 0; i < TAR_STATS_MAX_FD; i++) stats_clear(&fd_stats[i]);
+#endif
+}
+
+/**
+ * Resets the counters of a given file descriptor, the global counters are left untouched.
+ *
+ * @param tar_fd A file descriptor, typically one that was just opened or is about to be closed.
+ *
+ * @return zero on success,
+ *         -1 if tar_fd has no counters of its own (TAR_STATS disabled or tar_fd >= TAR_STATS_MAX_FD)
+ */
+int tar_stats_reset_fd(int tar_fd) {
+#ifdef TAR_STATS
+    if (tar_fd < 0 || tar_fd >= TAR_STATS_MAX_FD) return -1;
+    stats_clear(&fd_stats[tar_fd]);
+    return 0;
+#else
+    (void) tar_fd;
+    return -1;
+#endif
+}
+
+/**
+ * Returns the name of an operation as used in the JSON dump, e.g. "read_file".
+ */
+const char *tar_op_name(tar_op_t op) {
+    static const char *const names[TAR_OP_COUNT] = {
+            "check_archive", "exists", "is_dir", "is_file", "is_symlink", "list", "read_file"
+    };
+    return (op >= 0 && op < TAR_OP_COUNT) ? names[op] : "unknown";
+}
+
+/**
+ * Writes counters as a single-line JSON object followed by a newline.
+ *
+ * @param stats The counters to write.
+ * @param out The stream to write to.
+ */
+void tar_stats_dump_json(const tar_stats_t *stats, FILE *out) {
+    fprintf(out, "{\"headers_scanned\":%" PRIu64 ",\"blocks_scanned\":%" PRIu64 ",\"bytes_read\":%" PRIu64
+                 ",\"reads\":%" PRIu64 ",\"seeks\":%" PRIu64 ",\"links_resolved\":%" PRIu64 ",\"link_hops\":%" PRIu64
+                 ",\"max_link_depth\":%" PRIu64 ",\"ops\":{",
+            stats->headers_scanned, stats->blocks_scanned, stats->bytes_read, stats->reads, stats->seeks,
+            stats->links_resolved, stats->link_hops, stats->max_link_depth);
+
+    for (int op = 0; op < TAR_OP_COUNT; op++) {
+        const tar_op_stats_t *op_stats = &stats->ops[op];
+        fprintf(out, "%s\"%s\":{\"calls\":%" PRIu64 ",\"total_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64
+                     ",\"latency_log2_ns\":[",
+                op == 0 ? "" : ",", tar_op_name(op), op_stats->calls, op_stats->total_ns, op_stats->max_ns);
+        for (int i = 0; i < TAR_STATS_BUCKETS; i++) fprintf(out, "%s%" PRIu64, i == 0 ? "" : ",", op_stats->latency[i]);
+        fprintf(out, "]}");
+    }
+    fprintf(out, "}}\n");
+}
+
+/**
+ * Call read() on the archive and account for it.
+ *
+ * @param tar_fd A file descriptor pointing to a tar archive.
+ * @param buf The destination buffer.
+ * @param count The number of bytes to read.
+ * @return the value returned by read().
+ */
+static ssize_t tar_read(int tar_fd, void *buf, size_t count) {
+    ssize_t n = read(tar_fd, buf, count);
+    STATS_ADD(tar_fd, reads, 1);
+    if (n > 0) STATS_ADD(tar_fd, bytes_read, n);
+    return n;
+}
+
+/**
+ * Call lseek() on the archive and account for it.
+ *
+ * @param tar_fd A file descriptor pointing to a tar archive.
+ * @param offset The offset, interpreted according to whence.
+ * @param whence SEEK_SET, SEEK_CUR or SEEK_END.
+ * @return the value returned by lseek().
+ */
+static off_t tar_lseek(int tar_fd, off_t offset, int whence) {
+    STATS_ADD(tar_fd, seeks, 1);
+    return lseek(tar_fd, offset, whence);
+}
+
+/**
+ * Read the next header of the archive.
+ *
+ * @param tar_fd A file descriptor pointing to a header in a tar archive.
+ * @param tar_header The destination of the header.
+ * @return the value returned by read().
+ */
+static ssize_t read_header(int tar_fd, tar_header_t *tar_header) {
+    ssize_t n = tar_read(tar_fd, tar_header, sizeof(tar_header_t));
+    if (n > 0) STATS_ADD(tar_fd, headers_scanned, 1);
+    return n;
+}
+
 /**
  * Check if the current header has an empty name.
  *
@@ -52,9 +264,10 @@ off_t next_offset_header(const tar_header_t *const tar_header) {
  *         -1 if the file doesn't exist
  */
 off_t offset_header(int tar_fd, char *path) {
-    lseek(tar_fd, 0, SEEK_SET);
+    tar_lseek(tar_fd, 0, SEEK_SET);
     tar_header_t *tar_header = (tar_header_t *) malloc(sizeof(tar_header_t));
-    for (off_t offset = 0; read(tar_fd, tar_header, sizeof(tar_header_t)) > 0; offset++) {
+    for (off_t offset = 0; tar_read(tar_fd, tar_header, sizeof(tar_header_t)) > 0; offset++) {
+        STATS_ADD(tar_fd, blocks_scanned, 1);
         if (strcmp(tar_header->name, path) == 0) {free(tar_header); return (off_t) sizeof(tar_header_t) * offset;}
     }
     free(tar_header);
@@ -112,20 +325,22 @@ int check_chksum(char *address_tar) {
  *         -3 if the archive contains a header with an invalid checksum value
  */
 int check_archive(int tar_fd) {
-    lseek(tar_fd, 0, SEEK_SET); // Point at the beginning of the archive
+    uint64_t start = stats_begin();
+    tar_lseek(tar_fd, 0, SEEK_SET); // Point at the beginning of the archive
     tar_header_t *tar_header = (tar_header_t *) malloc(sizeof(tar_header_t));
 
     int nbr_files = 0;
-    for (; read(tar_fd, tar_header, sizeof(tar_header_t)) > 0; nbr_files++) {
+    for (; read_header(tar_fd, tar_header) > 0; nbr_files++) {
         if (is_tar_eof(tar_header)) break;
 
         int res = check_magic_and_version(tar_header);
         if (res == 0) res = check_chksum((char *) tar_header);
         if (res != 0) { nbr_files = res; break; }
-        lseek(tar_fd, next_offset_header(tar_header), SEEK_CUR);
+        tar_lseek(tar_fd, next_offset_header(tar_header), SEEK_CUR);
     }
 
     free(tar_header);
+    stats_end(tar_fd, TAR_OP_CHECK_ARCHIVE, start);
     return nbr_files;
 }
 
@@ -139,10 +354,12 @@ int check_archive(int tar_fd) {
  *         any other value otherwise.
  */
 int exists(int tar_fd, char *path) {
-    lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
+    uint64_t start = stats_begin();
+    tar_lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
     tar_header_t *tar_header = (tar_header_t *) malloc(sizeof(tar_header_t));
-    bool checking = read(tar_fd, tar_header, sizeof(tar_header_t)) > 0;
+    bool checking = read_header(tar_fd, tar_header) > 0;
     free(tar_header);
+    stats_end(tar_fd, TAR_OP_EXISTS, start);
     return checking;
 }
 
@@ -156,10 +373,12 @@ int exists(int tar_fd, char *path) {
  *         any other value otherwise.
  */
 int is_dir(int tar_fd, char *path) {
-    lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
+    uint64_t start = stats_begin();
+    tar_lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
     tar_header_t *tar_header = (tar_header_t *) malloc(sizeof(tar_header_t));
-    bool checking = read(tar_fd, tar_header, sizeof(tar_header_t)) > 0 && strcmp(tar_header->name, path) == 0 && tar_header->typeflag == DIRTYPE;
+    bool checking = read_header(tar_fd, tar_header) > 0 && strcmp(tar_header->name, path) == 0 && tar_header->typeflag == DIRTYPE;
     free(tar_header);
+    stats_end(tar_fd, TAR_OP_IS_DIR, start);
     return checking;
 }
 
@@ -173,10 +392,12 @@ int is_dir(int tar_fd, char *path) {
  *         any other value otherwise.
  */
 int is_file(int tar_fd, char *path) {
-    lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
+    uint64_t start = stats_begin();
+    tar_lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
     tar_header_t *tar_header = (tar_header_t *) malloc(sizeof(tar_header_t));
-    bool checking = read(tar_fd, tar_header, sizeof(tar_header_t)) > 0 && strcmp(tar_header->name, path) == 0 && tar_header->typeflag == REGTYPE;
+    bool checking = read_header(tar_fd, tar_header) > 0 && strcmp(tar_header->name, path) == 0 && tar_header->typeflag == REGTYPE;
     free(tar_header);
+    stats_end(tar_fd, TAR_OP_IS_FILE, start);
     return checking;
 }
 
@@ -189,10 +410,12 @@ int is_file(int tar_fd, char *path) {
  *         any other value otherwise.
  */
 int is_symlink(int tar_fd, char *path) {
-    lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
+    uint64_t start = stats_begin();
+    tar_lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
     tar_header_t *tar_header = (tar_header_t *) malloc(sizeof(tar_header_t));
-    bool checking = read(tar_fd, tar_header, sizeof(tar_header_t)) > 0 && strcmp(tar_header->name, path) == 0 && tar_header->typeflag == SYMTYPE;
+    bool checking = read_header(tar_fd, tar_header) > 0 && strcmp(tar_header->name, path) == 0 && tar_header->typeflag == SYMTYPE;
     free(tar_header);
+    stats_end(tar_fd, TAR_OP_IS_SYMLINK, start);
     return checking;
 }
 
@@ -266,15 +489,18 @@ int redirect_linked_path(char *sym_path, char *link_name, char *link_path) {
 int loop_symlink(int tar_fd, tar_header_t *tar_header, const char *const path, char *res_path) {
     char *curr_path = malloc(sizeof(char)*100);
     memcpy(curr_path, path, sizeof(char)*100);
-    while (tar_header->typeflag == SYMTYPE || tar_header->typeflag == LNKTYPE) {
+    STATS_ADD(tar_fd, links_resolved, 1);
+    for (u_int depth = 1; tar_header->typeflag == SYMTYPE || tar_header->typeflag == LNKTYPE; depth++) {
+        STATS_ADD(tar_fd, link_hops, 1);
+        STATS_MAX(tar_fd, max_link_depth, depth);
         redirect_linked_path(curr_path, tar_header->linkname, res_path);
-        lseek(tar_fd, offset_header(tar_fd, res_path), SEEK_SET);
-        long result = read(tar_fd, tar_header, sizeof(tar_header_t));
+        tar_lseek(tar_fd, offset_header(tar_fd, res_path), SEEK_SET);
+        long result = read_header(tar_fd, tar_header);
 
         if (result <= 0) { // link_path not found
             dir_parser(res_path); // Maybe a directory
-            lseek(tar_fd, offset_header(tar_fd, res_path), SEEK_SET);
-            result = read(tar_fd, tar_header, sizeof(tar_header_t));
+            tar_lseek(tar_fd, offset_header(tar_fd, res_path), SEEK_SET);
+            result = read_header(tar_fd, tar_header);
             if (result <= 0) { free(curr_path); return -1; }
         }
 
@@ -286,33 +512,14 @@ int loop_symlink(int tar_fd, tar_header_t *tar_header, const char *const path, c
 }
 
 /**
- * Lists the entries at a given path in the archive.
- * list() does not recurse into the directories listed at the given path.
- *
- * Example:
- *  dir/          list(..., "dir/", ...) lists "dir/a", "dir/b", "dir/c/" and "dir/e/"
- *   ├── a
- *   ├── b
- *   ├── c/
- *   │   └── d
- *   └── e/
- *
- * @param tar_fd A file descriptor pointing to the start of a valid tar archive file.
- * @param path A path to an entry in the archive. If the entry is a symlink, it must be resolved to its linked-to entry.
- * @param entries An array of char arrays, each one is long enough to contain a tar entry path.
- * @param no_entries An in-out argument.
- *                   The caller set it to the number of entries in `entries`.
- *                   The callee set it to the number of entries listed.
- *
- * @return zero if no directory at the given path exists in the archive,
- *         any other value otherwise.
+ * Implementation of list(), see below.
  */
-int list(int tar_fd, char *path, char **entries, size_t *no_entries) {
-    lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
+static int list_dir(int tar_fd, char *path, char **entries, size_t *no_entries) {
+    tar_lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET); // Point at the beginning of the file
     tar_header_t *tar_header = malloc(sizeof(tar_header_t));
 
     char *main_path; bool was_sym = false;
-    if (read(tar_fd, tar_header, sizeof(tar_header_t)) <= 0) { // path not found
+    if (read_header(tar_fd, tar_header) <= 0) { // path not found
         free(tar_header);
         *no_entries = 0;
         return 0;
@@ -334,8 +541,8 @@ int list(int tar_fd, char *path, char **entries, size_t *no_entries) {
     size_t nbr_curr_files = 0;
     char *sub_dir = malloc(sizeof(char)*100); bool curr_sub_dir_flag = false;
 
-    lseek(tar_fd, next_offset_header(tar_header), SEEK_CUR);
-    while (read(tar_fd, tar_header, sizeof(tar_header_t)) > 0){// || !end_folder || nbr_folder_needed > 0) {
+    tar_lseek(tar_fd, next_offset_header(tar_header), SEEK_CUR);
+    while (read_header(tar_fd, tar_header) > 0){// || !end_folder || nbr_folder_needed > 0) {
         if (!is_in_folder(main_path, tar_header->name) || nbr_curr_files >= *no_entries) break;
         /** !!! AT THIS STATE : tar_header exists && is in the directory analysed !!! **/
 
@@ -351,7 +558,7 @@ int list(int tar_fd, char *path, char **entries, size_t *no_entries) {
             }
         }
 
-        lseek(tar_fd, next_offset_header(tar_header), SEEK_CUR);
+        tar_lseek(tar_fd, next_offset_header(tar_header), SEEK_CUR);
     }
 
     *no_entries = nbr_curr_files;
@@ -361,33 +568,47 @@ int list(int tar_fd, char *path, char **entries, size_t *no_entries) {
     return nbr_curr_files <= 0 ? 0 : 1;
 }
 
+/**
+ * Lists the entries at a given path in the archive.
+ * list() does not recurse into the directories listed at the given path.
+ *
+ * Example:
+ *  dir/          list(..., "dir/", ...) lists "dir/a", "dir/b", "dir/c/" and "dir/e/"
+ *   ├── a
+ *   ├── b
+ *   ├── c/
+ *   │   └── d
+ *   └── e/
+ *
+ * @param tar_fd A file descriptor pointing to the start of a valid tar archive file.
+ * @param path A path to an entry in the archive. If the entry is a symlink, it must be resolved to its linked-to entry.
+ * @param entries An array of char arrays, each one is long enough to contain a tar entry path.
+ * @param no_entries An in-out argument.
+ *                   The caller set it to the number of entries in `entries`.
+ *                   The callee set it to the number of entries listed.
+ *
+ * @return zero if no directory at the given path exists in the archive,
+ *         any other value otherwise.
+ */
+int list(int tar_fd, char *path, char **entries, size_t *no_entries) {
+    uint64_t start = stats_begin();
+    int res = list_dir(tar_fd, path, entries, no_entries);
+    stats_end(tar_fd, TAR_OP_LIST, start);
+    return res;
+}
+
 size_t len_payload(size_t len_buf, size_t len_file, size_t offset) {
     if (len_buf < len_file - offset) return len_buf;
     return len_file-offset;
 }
 
 /**
- * Reads a file at a given path in the archive.
- *
- * @param tar_fd A file descriptor pointing to the start of a valid tar archive file.
- * @param path A path to an entry in the archive to read from.  If the entry is a symlink, it must be resolved to its linked-to entry.
- * @param offset An offset in the file from which to start reading from, zero indicates the start of the file.
- * @param dest A destination buffer to read the given file into.
- * @param len An in-out argument.
- *            The caller set it to the size of dest.
- *            The callee set it to the number of bytes written to dest.
- *
- * @return -1 if no entry at the given path exists in the archive or the entry is not a file,
- *         -2 if the offset is outside the file total length,
- *         zero if the file was read in its entirety into the destination buffer,
- *         a positive value if the file was partially read, representing the remaining bytes left to be read to reach
- *         the end of the file.
- *
+ * Implementation of read_file(), see below.
  */
-ssize_t read_file(int tar_fd, char *path, size_t offset, uint8_t *dest, size_t *len) {
-    lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET);
+static ssize_t read_entry(int tar_fd, char *path, size_t offset, uint8_t *dest, size_t *len) {
+    tar_lseek(tar_fd, offset_header(tar_fd, path), SEEK_SET);
     tar_header_t *tar_header = malloc(sizeof(tar_header_t));
-    if (read(tar_fd, tar_header, sizeof(tar_header_t)) <= 0) return -1;
+    if (read_header(tar_fd, tar_header) <= 0) return -1;
     char *curr_path = malloc(sizeof(char) * 100);
 
     if (tar_header->typeflag == SYMTYPE || tar_header->typeflag == LNKTYPE) { // path is a symlink
@@ -400,14 +621,14 @@ ssize_t read_file(int tar_fd, char *path, size_t offset, uint8_t *dest, size_t *
 
     char flag = tar_header->typeflag;
     size_t size = TAR_INT(tar_header->size);
-    int status_code = 0;
+    ssize_t status_code = 0;
 
     if (flag == REGTYPE || flag == AREGTYPE) {
         if (offset > size) return -2;
         size_t len_buf = len_payload(*len, size, offset);
 
-        lseek(tar_fd, (off_t) offset, SEEK_CUR);
-        read(tar_fd, dest, len_buf);
+        tar_lseek(tar_fd, (off_t) offset, SEEK_CUR);
+        tar_read(tar_fd, dest, len_buf);
         *len = len_buf;
         free(tar_header);
         status_code = size - offset - len_buf;
@@ -419,4 +640,29 @@ ssize_t read_file(int tar_fd, char *path, size_t offset, uint8_t *dest, size_t *
     }
 
     return status_code;
+}
+
+/**
+ * Reads a file at a given path in the archive.
+ *
+ * @param tar_fd A file descriptor pointing to the start of a valid tar archive file.
+ * @param path A path to an entry in the archive to read from.  If the entry is a symlink, it must be resolved to its linked-to entry.
+ * @param offset An offset in the file from which to start reading from, zero indicates the start of the file.
+ * @param dest A destination buffer to read the given file into.
+ * @param len An in-out argument.
+ *            The caller set it to the size of dest.
+ *            The callee set it to the number of bytes written to dest.
+ *
+ * @return -1 if no entry at the given path exists in the archive or the entry is not a file,
+ *         -2 if the offset is outside the file total length,
+ *         zero if the file was read in its entirety into the destination buffer,
+ *         a positive value if the file was partially read, representing the remaining bytes left to be read to reach
+ *         the end of the file.
+ *
+ */
+ssize_t read_file(int tar_fd, char *path, size_t offset, uint8_t *dest, size_t *len) {
+    uint64_t start = stats_begin();
+    ssize_t res = read_entry(tar_fd, path, offset, dest, len);
+    stats_end(tar_fd, TAR_OP_READ_FILE, start);
+    return res;
 }
\ No newline at end of file
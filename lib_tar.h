@@ -153,4 +153,107 @@ int list(int tar_fd, char *path, char **entries, size_t *no_entries);
  */
 ssize_t read_file(int tar_fd, char *path, size_t offset, uint8_t *dest, size_t *len);
 
+/**
+ * Instrumentation.
+ *
+ * When the library is compiled with -DTAR_STATS (e.g. `make STATS=1`), every call to the functions above updates a
+ * global set of counters and the set of counters of the file descriptor it was called with. Without TAR_STATS the
+ * counters are never touched and the functions below only report zeros.
+ *
+ * The counters of a file descriptor are kept by number: they are not cleared when it is closed, so an archive opened
+ * later under the same number inherits them unless tar_stats_reset_fd() is called. File descriptors greater than or
+ * equal to TAR_STATS_MAX_FD only update the global counters.
+ *
+ * The counters are updated with relaxed atomics, so calls may run concurrently on different file descriptors and
+ * concurrently with tar_stats_get*() and tar_stats_reset*(). A snapshot taken during calls is not consistent across
+ * fields.
+ */
+
+/* Upper bound (exclusive) of the file descriptors that get their own counters */
+#ifndef TAR_STATS_MAX_FD
+#define TAR_STATS_MAX_FD 256
+#endif
+
+/* Bucket i of a latency histogram counts the calls that took [2^i, 2^(i+1)) nanoseconds, the last one is open */
+#define TAR_STATS_BUCKETS 32
+
+typedef enum tar_op
+{
+    TAR_OP_CHECK_ARCHIVE,
+    TAR_OP_EXISTS,
+    TAR_OP_IS_DIR,
+    TAR_OP_IS_FILE,
+    TAR_OP_IS_SYMLINK,
+    TAR_OP_LIST,
+    TAR_OP_READ_FILE,
+    TAR_OP_COUNT
+} tar_op_t;
+
+typedef struct tar_op_stats
+{
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t latency[TAR_STATS_BUCKETS];
+} tar_op_stats_t;
+
+typedef struct tar_stats
+{
+    uint64_t headers_scanned;     /* headers read once located, lookup scans excluded (see blocks_scanned) */
+    uint64_t blocks_scanned;      /* blocks read one by one while looking an entry up, data blocks included */
+    uint64_t bytes_read;          /* bytes returned by read(), headers included */
+    uint64_t reads;               /* read() syscalls */
+    uint64_t seeks;               /* lseek() syscalls */
+    uint64_t links_resolved;      /* symlinks/hardlinks followed by list() and read_file() */
+    uint64_t link_hops;           /* links followed while resolving them */
+    uint64_t max_link_depth;      /* longest chain of links followed at once */
+    tar_op_stats_t ops[TAR_OP_COUNT];
+} tar_stats_t;
+
+/**
+ * Copies the counters of all the calls made so far.
+ *
+ * @param stats The destination of the counters.
+ */
+void tar_stats_get(tar_stats_t *stats);
+
+/**
+ * Copies the counters of the calls made so far with a given file descriptor.
+ *
+ * @param tar_fd A file descriptor previously given to the functions above.
+ * @param stats The destination of the counters.
+ *
+ * @return zero on success,
+ *         -1 if tar_fd has no counters of its own (TAR_STATS disabled or tar_fd >= TAR_STATS_MAX_FD)
+ */
+int tar_stats_get_fd(int tar_fd, tar_stats_t *stats);
+
+/**
+ * Resets the global counters and the counters of every file descriptor.
+ */
+void tar_stats_reset(void);
+
+/**
+ * Resets the counters of a given file descriptor, the global counters are left untouched.
+ *
+ * @param tar_fd A file descriptor, typically one that was just opened or is about to be closed.
+ *
+ * @return zero on success,
+ *         -1 if tar_fd has no counters of its own (TAR_STATS disabled or tar_fd >= TAR_STATS_MAX_FD)
+ */
+int tar_stats_reset_fd(int tar_fd);
+
+/**
+ * Returns the name of an operation as used in the JSON dump, e.g. "read_file".
+ */
+const char *tar_op_name(tar_op_t op);
+
+/**
+ * Writes counters as a single-line JSON object followed by a newline.
+ *
+ * @param stats The counters to write.
+ * @param out The stream to write to.
+ */
+void tar_stats_dump_json(const tar_stats_t *stats, FILE *out);
+
 #endif
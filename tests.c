@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <inttypes.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -37,9 +38,33 @@ int main(int argc, char **argv) {
         return -1;
     }
 
+    int failures = 0;
+#ifdef TAR_STATS
+    tar_stats_reset_fd(fd); // fd may reuse the number of a previously closed archive
+#endif
+
     int ret = check_archive(fd);
     printf("check_archive returned %d, and should return [0..inf]\n", ret);
 
+    // tar_stats_*() tests, check_archive() reads every header and the null header ending the archive
+    printf("\n\n=========================\n|| tar_stats_*() tests ||\n=========================\n\n");
+    tar_stats_t check_stats;
+#ifdef TAR_STATS
+    int get_fd = tar_stats_get_fd(fd, &check_stats);
+    printf("tar_stats_get_fd returned %d, and should return 0\n", get_fd);
+    failures += get_fd != 0;
+    printf("check_archive calls = %" PRIu64 ", and should be 1\n", check_stats.ops[TAR_OP_CHECK_ARCHIVE].calls);
+    failures += check_stats.ops[TAR_OP_CHECK_ARCHIVE].calls != 1;
+    printf("headers_scanned = %" PRIu64 ", and should be %d\n", check_stats.headers_scanned, ret + 1);
+    failures += check_stats.headers_scanned != (uint64_t) ret + 1;
+    printf("reads = %" PRIu64 ", seeks = %" PRIu64 ", and should both be > 0\n", check_stats.reads, check_stats.seeks);
+    failures += check_stats.reads == 0 || check_stats.seeks == 0;
+#else
+    int get_fd = tar_stats_get_fd(fd, &check_stats);
+    printf("tar_stats_get_fd returned %d, and should return -1 (built without TAR_STATS)\n", get_fd);
+    failures += get_fd != -1;
+#endif
+
 
     // Tests with symlink.tar
 
@@ -98,5 +123,12 @@ int main(int argc, char **argv) {
     free(dest);
     free(len);
 
-    return 0;
+#ifdef TAR_STATS
+    printf("\n\n===================\n|| tar_stats_*() ||\n===================\n\n");
+    tar_stats_t stats;
+    tar_stats_get_fd(fd, &stats);
+    tar_stats_dump_json(&stats, stdout);
+#endif
+
+    return failures == 0 ? 0 : 1;
 }
\ No newline at end of file